@@ -0,0 +1,346 @@
+#ifndef COMPACT_GRAPH_H
+#define COMPACT_GRAPH_H
+
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+#include "DirectedGraph.h"
+#include "GraphOrdering.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace ex{
+
+	/*Storage for the edge weights of a 'CompactGraph'. Unweighted graphs use the
+	specialization below, which stores nothing at all.*/
+	template <class W> struct EdgeWeights{
+		template <class D> void push_back(const Neighbor<D, W> &edge){ values.push_back(edge.weight); }
+		W operator[](std::size_t edge) const{ return values[edge]; }
+		std::vector<W> values;
+	};
+	template <> struct EdgeWeights<unweighted>{
+		template <class D> void push_back(const Neighbor<D, unweighted> &){}
+		unweighted operator[](std::size_t) const{ return unweighted(); }
+	};
+
+	/*Set of BFS sources (lanes) represented as a bitmask, 64 lanes per word.*/
+	template <std::size_t Words> struct LaneSet{
+		std::uint64_t words[Words];
+
+		LaneSet(){ reset(); }
+		void reset(){
+			for (std::size_t i = 0; i < Words; ++i)
+				words[i] = 0;
+		}
+		bool any() const{
+			for (std::size_t i = 0; i < Words; ++i)
+				if (words[i])
+					return true;
+			return false;
+		}
+		void set(std::size_t lane){
+			words[lane / 64] |= std::uint64_t(1) << (lane % 64);
+		}
+		LaneSet<Words> &operator|=(const LaneSet<Words> &other){
+			for (std::size_t i = 0; i < Words; ++i)
+				words[i] |= other.words[i];
+			return *this;
+		}
+		/*Keeps only the lanes that are not in 'other'.*/
+		void removeAll(const LaneSet<Words> &other){
+			for (std::size_t i = 0; i < Words; ++i)
+				words[i] &= ~other.words[i];
+		}
+		/*Calls 'func' with the index of each lane that is set.*/
+		template <class F> void forEach(F func) const{
+			for (std::size_t i = 0; i < Words; ++i){
+				for (std::uint64_t bits = words[i]; bits; bits &= bits - 1){
+					func(i * 64 + lowestBit(bits));
+				}
+			}
+		}
+		static std::size_t lowestBit(std::uint64_t bits){
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+			unsigned long pos;
+			_BitScanForward64(&pos, bits);
+			return pos;
+#elif defined(_MSC_VER)
+			/*32-bit builds only have the 32-bit scan.*/
+			unsigned long pos;
+			if (_BitScanForward(&pos, static_cast<unsigned long>(bits)))
+				return pos;
+			_BitScanForward(&pos, static_cast<unsigned long>(bits >> 32));
+			return 32 + pos;
+#else
+			return __builtin_ctzll(bits);
+#endif
+		}
+	};
+
+	/*Mapping between the ids of a graph snapshot and the nodes of the original graph. Snapshots
+	built from one another share the same index, so it is stored only once. Besides the node of
+	each id, it keeps the ids sorted by node address, so finding the id of a node is a binary
+	search, and the whole mapping takes 12 bytes per node.*/
+	template <class D, class W> class NodeIndex{
+
+	public:
+
+		using id_type = std::uint32_t;
+
+		explicit NodeIndex(std::vector<GraphNode<D, W>*> byId) : nodes(std::move(byId)), byAddress(nodes.size()){
+			std::iota(byAddress.begin(), byAddress.end(), id_type(0));
+			std::sort(byAddress.begin(), byAddress.end(), [&](id_type a, id_type b){
+				return std::less<GraphNode<D, W>*>()(nodes[a], nodes[b]);
+			});
+		}
+
+		id_type size() const{
+			return static_cast<id_type>(nodes.size());
+		}
+		GraphNode<D, W> *getNode(id_type id) const{
+			return nodes[id];
+		}
+		/*Throws std::out_of_range if the node is not part of the graph.*/
+		id_type getId(GraphNode<D, W> *node) const{
+			auto pos = std::lower_bound(byAddress.begin(), byAddress.end(), node, [&](id_type id, GraphNode<D, W> *n){
+				return std::less<GraphNode<D, W>*>()(nodes[id], n);
+			});
+			if (pos == byAddress.end() || nodes[*pos] != node)
+				throw std::out_of_range("The node is not part of this graph.");
+			return *pos;
+		}
+
+		std::size_t byteSize() const{
+			return sizeof(*this) + nodes.capacity() * sizeof(GraphNode<D, W>*) + byAddress.capacity() * sizeof(id_type);
+		}
+
+	private:
+		std::vector<GraphNode<D, W>*> nodes;
+		std::vector<id_type> byAddress;
+	};
+
+	/*Read-only snapshot of a 'DirectedGraph' in compressed sparse row form. Nodes are
+	renumbered with 32-bit ids, and all edges are stored in a single contiguous array, so
+	an edge takes 4 bytes (plus its weight, if any) instead of a whole list node. The
+	snapshot is not updated if the original graph changes afterwards.*/
+	template <class D, class W> class CompactGraph{
+
+	public:
+
+		using id_type = std::uint32_t;
+
+		/*Hop distance reported for nodes that can't be reached from a source.*/
+		static const id_type unreachable = 0xFFFFFFFFu;
+
+		/*Ids follow the insertion order of the graph, unless another 'ordering' is requested, in 
+		which case nodes are renumbered so the ones traversed together get nearby ids. Use 'getNode' 
+		and 'getData' to map the new ids back to the original nodes.*/
+		CompactGraph(const DirectedGraph<D, W> &graph, VertexOrdering ordering = VertexOrdering::Insertion){
+			const std::list<GraphNode<D, W>*> &graphNodes = graph.getNodes();
+			std::vector<GraphNode<D, W>*> nodes(graphNodes.begin(), graphNodes.end());
+			build(nodes);
+
+			if (ordering != VertexOrdering::Insertion){
+				std::vector<id_type> order = compute_ordering(offsets, targets, ordering);
+				std::vector<GraphNode<D, W>*> reordered(nodes.size());
+				for (id_type id = 0; id < order.size(); ++id){
+					reordered[id] = nodes[order[id]];
+				}
+				nodes.swap(reordered);
+				build(nodes);
+			}
+			index = std::make_shared<NodeIndex<D, W>>(std::move(nodes));
+		}
+
+		id_type size() const{
+			return index->size();
+		}
+		std::size_t edgeCount() const{
+			return targets.size();
+		}
+
+		/*Mapping between ids and the nodes of the original graph.*/
+		id_type getId(GraphNode<D, W> *node) const{
+			return index->getId(node);
+		}
+		GraphNode<D, W> *getNode(id_type id) const{
+			return index->getNode(id);
+		}
+		const D &getData(id_type id) const{
+			return index->getNode(id)->data;
+		}
+		const std::shared_ptr<const NodeIndex<D, W>> &getIndex() const{
+			return index;
+		}
+
+		/*The edges leaving node 'id' are the ones in [firstEdge(id), lastEdge(id)).*/
+		std::size_t firstEdge(id_type id) const{
+			return offsets[id];
+		}
+		std::size_t lastEdge(id_type id) const{
+			return offsets[id + 1];
+		}
+		id_type target(std::size_t edge) const{
+			return targets[edge];
+		}
+		W weight(std::size_t edge) const{
+			return weights[edge];
+		}
+
+		void bfs_left_first(id_type node, std::function<void(id_type)> func) const;
+		void bfs_left_first(GraphNode<D, W> *node, std::function<void(GraphNode<D, W>*)> func) const{
+			bfs_left_first(getId(node), [&](id_type id){ func(getNode(id)); });
+		}
+
+		/*Computes the hop distance from every source to every node, running 'Lanes' BFS traversals 
+		at once in a single sweep over the edges (MS-BFS). Each node keeps a bitmask of the sources 
+		that reached it, so traversals sharing parts of the graph share the work as well. More 
+		sources than 'Lanes' are processed in successive batches. The result is indexed as
+		[source][node id], with 'unreachable' for nodes that can't be reached.*/
+		template <std::size_t Lanes = 64> std::vector<std::vector<id_type>> bfs_multi_source(
+			const std::vector<id_type> &sources) const;
+		template <std::size_t Lanes = 64> std::vector<std::vector<id_type>> bfs_multi_source(
+			const std::vector<GraphNode<D, W>*> &sources) const
+		{
+			std::vector<id_type> sourceIds;
+			sourceIds.reserve(sources.size());
+			for (GraphNode<D, W> *n : sources){
+				sourceIds.push_back(getId(n));
+			}
+			return bfs_multi_source<Lanes>(sourceIds);
+		}
+
+	private:
+
+		/*Fills the edge arrays, giving each node its position in 'nodes' as id.*/
+		void build(const std::vector<GraphNode<D, W>*> &nodes){
+			std::unordered_map<GraphNode<D, W>*, id_type> ids;
+			for (id_type id = 0; id < nodes.size(); ++id){
+				ids[nodes[id]] = id;
+			}
+
+			offsets.assign(1, 0);
+			offsets.reserve(nodes.size() + 1);
+			targets.clear();
+			weights = EdgeWeights<W>();
+			for (GraphNode<D, W> *n : nodes){
+				for (Neighbor<D, W> &nei : n->neighbors){
+					/*Throws if the neighbor is not part of the graph, which happens when nodes are
+					connected with 'GraphNode::addConnection' instead of through the graph.*/
+					targets.push_back(ids.at(nei.node));
+					weights.push_back(nei);
+				}
+				offsets.push_back(targets.size());
+			}
+		}
+
+		template <std::size_t Words> void _bfs_multi_source_batch(const id_type *sources, std::size_t count,
+			std::vector<id_type> **distances) const;
+
+		std::shared_ptr<const NodeIndex<D, W>> index;
+
+		/*Edges of node 'i' are stored in 'targets' from offsets[i] to offsets[i + 1].*/
+		std::vector<std::size_t> offsets;
+		std::vector<id_type> targets;
+		EdgeWeights<W> weights;
+
+	};
+
+	template <class D, class W> void ex::CompactGraph<D, W>::bfs_left_first(
+		id_type node, std::function<void(id_type)> func) const
+	{
+		/*Visiting status is kept here instead of in the nodes, so the original graph is left untouched.*/
+		std::vector<bool> queued(size(), false);
+		std::vector<id_type> que;
+		que.reserve(size());
+		que.push_back(node);
+		queued[node] = true;
+		for (std::size_t head = 0; head < que.size(); ++head){
+			id_type n = que[head];
+			func(n);
+			for (std::size_t e = offsets[n]; e < offsets[n + 1]; ++e){
+				if (!queued[targets[e]]){
+					queued[targets[e]] = true;
+					que.push_back(targets[e]);
+				}
+			}
+		}
+	}
+
+	template <class D, class W> const typename ex::CompactGraph<D, W>::id_type ex::CompactGraph<D, W>::unreachable;
+
+	template <class D, class W> template <std::size_t Lanes> std::vector<std::vector<typename ex::CompactGraph<D, W>::id_type>>
+		ex::CompactGraph<D, W>::bfs_multi_source(const std::vector<id_type> &sources) const
+	{
+		static_assert(Lanes > 0 && Lanes % 64 == 0, "The number of lanes must be a multiple of 64.");
+
+		std::vector<std::vector<id_type>> distances(sources.size(), std::vector<id_type>(size(), unreachable));
+		std::vector<std::vector<id_type>*> batch(Lanes);
+		for (std::size_t first = 0; first < sources.size(); first += Lanes){
+			std::size_t count = std::min(Lanes, sources.size() - first);
+			for (std::size_t lane = 0; lane < count; ++lane){
+				batch[lane] = &distances[first + lane];
+			}
+			_bfs_multi_source_batch<Lanes / 64>(&sources[first], count, batch.data());
+		}
+		return distances;
+	}
+
+	template <class D, class W> template <std::size_t Words> void ex::CompactGraph<D, W>::_bfs_multi_source_batch(
+		const id_type *sources, std::size_t count, std::vector<id_type> **distances) const
+	{
+		/*'seen' holds the sources that already reached each node, 'visit' the ones reaching it in 
+		the current level, and 'visitNext' the ones that will reach it in the next level.*/
+		std::vector<LaneSet<Words>> seen(size()), visit(size()), visitNext(size());
+		std::vector<id_type> frontier, nextFrontier;
+
+		for (std::size_t lane = 0; lane < count; ++lane){
+			id_type s = sources[lane];
+			if (!visit[s].any())
+				frontier.push_back(s);
+			seen[s].set(lane);
+			visit[s].set(lane);
+			(*distances[lane])[s] = 0;
+		}
+
+		for (id_type level = 1; !frontier.empty(); ++level){
+			for (id_type n : frontier){
+				for (std::size_t e = offsets[n]; e < offsets[n + 1]; ++e){
+					LaneSet<Words> &next = visitNext[targets[e]];
+					if (!next.any())
+						nextFrontier.push_back(targets[e]);
+					next |= visit[n];
+				}
+				visit[n].reset();
+			}
+
+			/*Only the sources that had not reached a node yet are kept, so each source walks
+			through each node a single time, as in a regular BFS.*/
+			frontier.clear();
+			for (id_type n : nextFrontier){
+				LaneSet<Words> &next = visitNext[n];
+				next.removeAll(seen[n]);
+				if (next.any()){
+					seen[n] |= next;
+					next.forEach([&](std::size_t lane){
+						(*distances[lane])[n] = level;
+					});
+					visit[n] = next;
+					frontier.push_back(n);
+				}
+				next.reset();
+			}
+			nextFrontier.clear();
+		}
+	}
+
+};
+
+#endif
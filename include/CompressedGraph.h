@@ -0,0 +1,392 @@
+#ifndef COMPRESSED_GRAPH_H
+#define COMPRESSED_GRAPH_H
+
+#include <list>
+#include <vector>
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include "CompactGraph.h"
+
+namespace ex{
+
+	/*Encoding of the edge weights of a 'CompressedGraph', stored right after the targets of each
+	node. Weights are either copied as they are, or quantized to a single byte, in which case they
+	are decoded to the nearest of 256 values evenly spread between the lowest and highest weight.
+	Weights must be of an arithmetic type. Unweighted graphs use the specialization below.*/
+	template <class W> struct CompressedWeights{
+
+		static_assert(std::is_arithmetic<W>::value, "Weights of a CompressedGraph must be of an arithmetic type.");
+
+		/*Finds the range of the weights of 'graph', in a single pass, and sets it up for encoding.*/
+		template <class D> void fit(const CompactGraph<D, W> &graph, bool quantize){
+			if (!quantize || graph.edgeCount() == 0){
+				setRange(W(), W(), quantize);
+				return;
+			}
+			W lowestWeight = graph.weight(0), highestWeight = lowestWeight;
+			for (std::size_t e = 1; e < graph.edgeCount(); ++e){
+				W weight = graph.weight(e);
+				if (weight < lowestWeight)
+					lowestWeight = weight;
+				if (highestWeight < weight)
+					highestWeight = weight;
+			}
+			setRange(lowestWeight, highestWeight, quantize);
+		}
+		void setRange(const W &lowestWeight, const W &highestWeight, bool quantize){
+			quantized = quantize;
+			lowest = static_cast<double>(lowestWeight);
+			step = (static_cast<double>(highestWeight) - lowest) / 255.0;
+		}
+		void encode(const W &weight, std::vector<std::uint8_t> &out) const{
+			if (quantized){
+				double q = step > 0 ? std::floor((static_cast<double>(weight) - lowest) / step + 0.5) : 0.0;
+				out.push_back(static_cast<std::uint8_t>(q));
+			}
+			else{
+				std::uint8_t bytes[sizeof(W)];
+				std::memcpy(bytes, &weight, sizeof(W));
+				out.insert(out.end(), bytes, bytes + sizeof(W));
+			}
+		}
+		W decode(const std::uint8_t *&in) const{
+			if (quantized){
+				double w = lowest + step * (*in++);
+				return static_cast<W>(std::is_integral<W>::value ? std::floor(w + 0.5) : w);
+			}
+			W weight;
+			std::memcpy(&weight, in, sizeof(W));
+			in += sizeof(W);
+			return weight;
+		}
+
+		bool quantized = false;
+		double lowest = 0.0;
+		double step = 0.0;
+	};
+	template <> struct CompressedWeights<unweighted>{
+		template <class D> void fit(const CompactGraph<D, unweighted> &, bool){}
+		void encode(const unweighted &, std::vector<std::uint8_t> &) const{}
+		unweighted decode(const std::uint8_t *&) const{ return unweighted(); }
+	};
+
+	/*Read-only form of a graph for when even a 'CompactGraph' doesn't fit in memory. The targets of
+	each node are sorted, stored as the difference to the previous one, and packed with group varint
+	encoding: a control byte holds the length (1 to 4 bytes) of the next four values, so they can
+	be decoded without any branches. When nodes were reordered for locality, differences are small,
+	and most edges take a bit over one byte. Ids are the same as in the 'CompactGraph' this graph was
+	built from, and the mapping back to the original nodes is shared with it rather than copied.
+
+	Decoding reads four bytes at a time as a little-endian integer, so this assumes a little-endian
+	machine (which covers x86 and x64).*/
+	template <class D, class W> class CompressedGraph{
+
+	public:
+
+		using id_type = std::uint32_t;
+
+		CompressedGraph(const CompactGraph<D, W> &graph, bool quantizeWeights = false){
+			index = graph.getIndex();
+			edges = graph.edgeCount();
+
+			weights.fit(graph, quantizeWeights);
+
+			blockOffsets.reserve((graph.size() + blockSize - 1) / blockSize);
+			offsets.reserve(graph.size());
+			std::vector<std::size_t> order;
+			std::vector<id_type> sorted;
+			for (id_type id = 0; id < graph.size(); ++id){
+				if (id % blockSize == 0)
+					blockOffsets.push_back(data.size());
+				if (data.size() - blockOffsets.back() > 0xFFFFFFFFu)
+					throw std::length_error("The edges of a block of nodes take more than 4 GiB.");
+				offsets.push_back(static_cast<std::uint32_t>(data.size() - blockOffsets.back()));
+
+				order.clear();
+				for (std::size_t e = graph.firstEdge(id); e < graph.lastEdge(id); ++e){
+					order.push_back(e);
+				}
+				std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b){
+					return graph.target(a) < graph.target(b);
+				});
+				sorted.clear();
+				for (std::size_t e : order){
+					sorted.push_back(graph.target(e));
+				}
+
+				_encode_varint(sorted.size());
+				_encode_targets(sorted);
+				for (std::size_t e : order){
+					weights.encode(graph.weight(e), data);
+				}
+			}
+
+			/*Decoding may read up to three bytes past the last value.*/
+			data.resize(data.size() + 4, 0);
+			data.shrink_to_fit();
+		}
+
+		id_type size() const{
+			return static_cast<id_type>(offsets.size());
+		}
+		std::size_t edgeCount() const{
+			return edges;
+		}
+		/*Bytes used by the encoded edges alone.*/
+		std::size_t edgeBytes() const{
+			return data.size();
+		}
+		/*Bytes used by the whole graph: the encoded edges, the offsets and the id to node mapping.
+		The mapping is shared with the 'CompactGraph', so it is counted by both.*/
+		std::size_t byteSize() const{
+			return sizeof(*this) + data.capacity() +
+				blockOffsets.capacity() * sizeof(std::uint64_t) +
+				offsets.capacity() * sizeof(std::uint32_t) +
+				index->byteSize();
+		}
+
+		/*Throws 'std::out_of_range' if the node is not part of this graph.*/
+		id_type getId(GraphNode<D, W> *node) const{
+			return index->getId(node);
+		}
+		GraphNode<D, W> *getNode(id_type id) const{
+			return index->getNode(id);
+		}
+		const D &getData(id_type id) const{
+			return index->getNode(id)->data;
+		}
+
+		std::size_t degree(id_type id) const{
+			const std::uint8_t *in = _edges(id);
+			return _decode_varint(in);
+		}
+
+		/*Decodes the targets of node 'id' into 'out', which must have room for 'degree(id)' values.
+		Targets come out in increasing order. Returns the number of targets.*/
+		std::size_t decodeNeighbors(id_type id, id_type *out) const{
+			const std::uint8_t *in = _edges(id);
+			std::size_t count = _decode_varint(in);
+			_decode_targets(in, count, out);
+			return count;
+		}
+
+		/*Calls 'func(target, weight)' for each edge leaving node 'id', in increasing target order.*/
+		template <class F> void forEachEdge(id_type id, F func) const{
+			const std::uint8_t *in = _edges(id);
+			std::size_t count = _decode_varint(in);
+			/*Weights start right after the targets, so the targets are decoded four at a time while
+			the weights are read alongside, without a buffer for all of them.*/
+			const std::uint8_t *weight = _skip_targets(in, count);
+			id_type group[4];
+			id_type previous = 0;
+			for (std::size_t i = 0; i < count; i += 4){
+				previous = _decode_group(in, previous, group);
+				for (std::size_t k = 0; k < 4 && i + k < count; ++k){
+					func(group[k], weights.decode(weight));
+				}
+			}
+		}
+
+		/*Traversals work as in 'DirectedGraph', except that neighbors are visited in
+		increasing id order, since that is how they are stored.*/
+		void bfs_left_first(id_type node, std::function<void(id_type)> func) const;
+		void bfs_left_first(GraphNode<D, W> *node, std::function<void(GraphNode<D, W>*)> func) const{
+			bfs_left_first(getId(node), [&](id_type id){ func(getNode(id)); });
+		}
+		void dfs_pre_order(id_type node, std::function<void(id_type)> func) const;
+		void dfs_pre_order(GraphNode<D, W> *node, std::function<void(GraphNode<D, W>*)> func) const{
+			dfs_pre_order(getId(node), [&](id_type id){ func(getNode(id)); });
+		}
+
+		/*Path with the fewest edges between the two nodes, found with a BFS. It is empty if
+		there is no such path.*/
+		std::list<GraphNode<D, W>*> getShortestPath(GraphNode<D, W> *from, GraphNode<D, W> *to) const;
+
+	private:
+
+		/*Nodes are split in blocks of this many, each with a 64-bit offset into 'data'. Nodes store
+		their offset relative to their block, in 32 bits.*/
+		static const id_type blockSize = 64;
+
+		const std::uint8_t *_edges(id_type id) const{
+			return &data[blockOffsets[id / blockSize] + offsets[id]];
+		}
+
+		void _decode_neighbors(id_type id, std::vector<id_type> &out) const{
+			const std::uint8_t *in = _edges(id);
+			std::size_t count = _decode_varint(in);
+			out.resize(count);
+			_decode_targets(in, count, out.data());
+		}
+
+		void _encode_varint(std::size_t value){
+			while (value >= 0x80){
+				data.push_back(static_cast<std::uint8_t>(value | 0x80));
+				value >>= 7;
+			}
+			data.push_back(static_cast<std::uint8_t>(value));
+		}
+		static std::size_t _decode_varint(const std::uint8_t *&in){
+			std::size_t value = 0;
+			for (int shift = 0;; shift += 7){
+				std::uint8_t byte = *in++;
+				value |= std::size_t(byte & 0x7F) << shift;
+				if (!(byte & 0x80))
+					return value;
+			}
+		}
+
+		/*Groups of four differences, each group preceded by a control byte holding the number of
+		bytes of each value minus one, two bits per value. The last group is padded with zeros.*/
+		void _encode_targets(const std::vector<id_type> &sorted){
+			id_type previous = 0;
+			for (std::size_t first = 0; first < sorted.size(); first += 4){
+				std::size_t control = data.size();
+				data.push_back(0);
+				for (std::size_t k = 0; k < 4; ++k){
+					id_type delta = 0;
+					if (first + k < sorted.size()){
+						delta = sorted[first + k] - previous;
+						previous = sorted[first + k];
+					}
+					std::size_t length = delta < (1u << 8) ? 1 : delta < (1u << 16) ? 2 : delta < (1u << 24) ? 3 : 4;
+					data[control] |= static_cast<std::uint8_t>((length - 1) << (2 * k));
+					for (std::size_t b = 0; b < length; ++b){
+						data.push_back(static_cast<std::uint8_t>(delta >> (8 * b)));
+					}
+				}
+			}
+		}
+		/*Decodes one group of four targets following 'previous', and returns the last of them.*/
+		static id_type _decode_group(const std::uint8_t *&in, id_type previous, id_type *out){
+			static const std::uint32_t masks[4] = { 0xFFu, 0xFFFFu, 0xFFFFFFu, 0xFFFFFFFFu };
+			unsigned control = *in++;
+			for (unsigned k = 0; k < 4; ++k){
+				unsigned length = (control >> (2 * k)) & 3;
+				std::uint32_t delta;
+				std::memcpy(&delta, in, sizeof(delta));
+				in += length + 1;
+				previous += delta & masks[length];
+				out[k] = previous;
+			}
+			return previous;
+		}
+		static void _decode_targets(const std::uint8_t *&in, std::size_t count, id_type *out){
+			id_type previous = 0;
+			std::size_t i = 0;
+			for (; i + 4 <= count; i += 4){
+				previous = _decode_group(in, previous, out + i);
+			}
+			if (i < count){
+				id_type last[4];
+				_decode_group(in, previous, last);
+				std::copy(last, last + (count - i), out + i);
+			}
+		}
+		/*Returns where the 'count' targets starting at 'in' end, reading only the control bytes.*/
+		static const std::uint8_t *_skip_targets(const std::uint8_t *in, std::size_t count){
+			for (std::size_t i = 0; i < count; i += 4){
+				unsigned control = *in;
+				in += 5 + (control & 3) + ((control >> 2) & 3) + ((control >> 4) & 3) + (control >> 6);
+			}
+			return in;
+		}
+
+		/*Mapping between ids and the nodes of the original graph, shared with the 'CompactGraph'.*/
+		std::shared_ptr<const NodeIndex<D, W>> index;
+
+		/*The encoded edges of node 'i' start at data[blockOffsets[i / blockSize] + offsets[i]], with
+		the number of edges stored as a varint, followed by the targets and then the weights.*/
+		std::vector<std::uint64_t> blockOffsets;
+		std::vector<std::uint32_t> offsets;
+		std::vector<std::uint8_t> data;
+		std::size_t edges = 0;
+		CompressedWeights<W> weights;
+
+	};
+
+	template <class D, class W> void ex::CompressedGraph<D, W>::bfs_left_first(
+		id_type node, std::function<void(id_type)> func) const
+	{
+		std::vector<bool> queued(size(), false);
+		std::vector<id_type> que, neighbors;
+		que.reserve(size());
+		que.push_back(node);
+		queued[node] = true;
+		for (std::size_t head = 0; head < que.size(); ++head){
+			id_type n = que[head];
+			func(n);
+			_decode_neighbors(n, neighbors);
+			for (id_type nei : neighbors){
+				if (!queued[nei]){
+					queued[nei] = true;
+					que.push_back(nei);
+				}
+			}
+		}
+	}
+
+	template <class D, class W> void ex::CompressedGraph<D, W>::dfs_pre_order(
+		id_type node, std::function<void(id_type)> func) const
+	{
+		/*Iterative, so very deep graphs don't overflow the call stack. Neighbors are stacked
+		in reverse, so they are visited in the same order as the recursive version would.*/
+		std::vector<bool> visited(size(), false);
+		std::vector<id_type> stack(1, node), neighbors;
+		while (!stack.empty()){
+			id_type n = stack.back();
+			stack.pop_back();
+			if (visited[n])
+				continue;
+			func(n);
+			visited[n] = true;
+
+			_decode_neighbors(n, neighbors);
+			for (auto it = neighbors.rbegin(); it != neighbors.rend(); ++it){
+				if (!visited[*it])
+					stack.push_back(*it);
+			}
+		}
+	}
+
+	template <class D, class W> std::list<GraphNode<D, W>*> ex::CompressedGraph<D, W>::getShortestPath(
+		GraphNode<D, W> *from, GraphNode<D, W> *to) const
+	{
+		std::list<GraphNode<D, W>*> shortestPath;
+		if (!from || !to)
+			return shortestPath;
+
+		id_type source = getId(from), target = getId(to);
+		const id_type none = static_cast<id_type>(size());
+		std::vector<id_type> parent(size(), none);
+		std::vector<id_type> que(1, source), neighbors;
+		parent[source] = source;
+		for (std::size_t head = 0; head < que.size() && parent[target] == none; ++head){
+			id_type n = que[head];
+			_decode_neighbors(n, neighbors);
+			for (id_type nei : neighbors){
+				if (parent[nei] == none){
+					parent[nei] = n;
+					que.push_back(nei);
+				}
+			}
+		}
+
+		if (parent[target] == none)
+			return shortestPath;
+		for (id_type n = target; n != source; n = parent[n]){
+			shortestPath.push_front(getNode(n));
+		}
+		shortestPath.push_front(getNode(source));
+		return shortestPath;
+	}
+
+};
+
+#endif
@@ -6,6 +6,7 @@
 #include <functional>
 #include <queue> 
 #include <initializer_list>
+#include <unordered_map>
 #include "GraphNode.h"
 
 namespace ex{
@@ -36,25 +37,50 @@ namespace ex{
 
 		/*Pushes a node into this graph, which will have no connections initially.*/
 		GraphNode<D, W> *&push(GraphNode<D, W> *node){
-			auto nodePos = std::find(nodes.begin(), nodes.end(), node);
-			if (nodePos == nodes.end()){
+			auto nodePos = nodeIndex.find(node);
+			if (nodePos == nodeIndex.end()){
 				nodes.push_back(node);
+				nodeIndex.emplace(node, std::prev(nodes.end()));
 				return nodes.back();
 			}
 			else
-				return *nodePos;
+				return *nodePos->second;
 
 		}
 
-		/*Erase a node from this graph.*/
+		/*Erase a node from this graph. This takes O(degree) time, since the node's 
+		edges are unlinked directly from the lists of its parents and neighbors.*/
 		void erase(GraphNode<D, W> *node){
-			auto nodePos = std::find(nodes.begin(), nodes.end(), node);
-			if (nodePos != nodes.end()){
-				nodes.erase(nodePos);
+			auto nodePos = nodeIndex.find(node);
+			if (nodePos != nodeIndex.end()){
+				nodes.erase(nodePos->second);
+				nodeIndex.erase(nodePos);
 				delete node;
 			}
 		}
 
+		/*Erase all nodes in the range [first, last). Nodes that are not part of this graph, or
+		that appear more than once, are ignored. The whole batch takes O(V + E) in the worst case.*/
+		template <class InputIt> void erase(InputIt first, InputIt last){
+			for (; first != last; ++first){
+				this->erase(*first);
+			}
+		}
+
+		/*Erase all nodes for which 'pred' returns true, in a single pass over the graph.*/
+		template <class Pred> void erase_if(Pred pred){
+			for (auto it = nodes.begin(); it != nodes.end();){
+				GraphNode<D, W> *n = *it;
+				if (pred(n)){
+					it = nodes.erase(it);
+					nodeIndex.erase(n);
+					delete n;
+				}
+				else
+					++it;
+			}
+		}
+
 		/*Returns the first node that has the given 'data'.*/
 		GraphNode<D, W> *getNodeByData(D data){
 			auto nodePos = std::find_if(nodes.begin(), nodes.end(), [&](GraphNode<D, W> *n){
@@ -67,8 +93,8 @@ namespace ex{
 		}
 
 		void make_bidirectional(GraphNode<D, W> *a, GraphNode<D, W> *b){
-			make_directional(a, b, 0);
-			make_directional(b, a, 0);
+			make_directional(a, b, W());
+			make_directional(b, a, W());
 		}
 		void make_bidirectional(GraphNode<D, W> *a, GraphNode<D, W> *b, W weightAtoB, W weightBtoA){
 			make_directional(a, b, weightAtoB);
@@ -81,6 +107,11 @@ namespace ex{
 			this->push(from)->addConnection(this->push(to), weight);
 		}
 
+		/*Read-only access to all nodes of this graph, in insertion order.*/
+		const std::list<GraphNode<D, W>*> &getNodes() const{
+			return nodes;
+		}
+
 		void resetVisitStatus(){
 			for (GraphNode<D, W> *n : nodes){
 				n->status = GraphNode<D, W>::Status::Unvisited;
@@ -154,6 +185,9 @@ namespace ex{
 		/*This is the master list holding all nodes of this graph.*/
 		std::list<GraphNode<D, W>*> nodes;
 
+		/*Position of each node inside 'nodes', so pushes and erases don't need a linear search.*/
+		std::unordered_map<GraphNode<D, W>*, typename std::list<GraphNode<D, W>*>::iterator> nodeIndex;
+
 	};
 
 	template <class D, class W> void ex::DirectedGraph<D, W>::bfs_left_first(
@@ -341,7 +375,7 @@ namespace ex{
 		std::queue<std::list<Neighbor<D, W>>> pathQue;
 
 		pathQue.push(std::list<Neighbor<D, W>>());
-		pathQue.front().push_back(Neighbor<D, W>(from,0));
+		pathQue.front().push_back(Neighbor<D, W>(from, W()));
 
 		while (!pathQue.empty()){
 			std::list<Neighbor<D, W>> actualPath = pathQue.front();
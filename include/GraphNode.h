@@ -1,10 +1,15 @@
 #include <list>
+#include <iterator>
 
 namespace ex{
 
 	/*Forward declaration*/
 	template <class D, class W> struct Neighbor;
 
+	/*Use this as the weight type 'W' for graphs whose edges have no weight. Edges
+	then carry no weight at all, and are compared only by the node they point to.*/
+	struct unweighted{};
+
 	/*This represents a vertex*/
 	template <class D, class W> class GraphNode{
 
@@ -14,13 +19,17 @@ namespace ex{
 		enum Status{ Visited, Unvisited, ToBeVisited };
 
 		GraphNode(D data) : data(data) {}
+		/*Edges are linked to both of their endpoints, so copying them would leave the 
+		copy pointing into lists it does not own. Only the data and status are copied.*/
+		GraphNode(const GraphNode<D, W> &other) : status(other.status), data(other.data) {}
+		/*Same as the copy constructor: this node keeps its own edges.*/
+		GraphNode<D, W> &operator=(const GraphNode<D, W> &other){
+			status = other.status;
+			data = other.data;
+			return *this;
+		}
 		~GraphNode(){
-			for (GraphNode<D, W> *par : parents){
-				par->removeConnection(this);
-			}
-			for (Neighbor<D, W> &nei : neighbors){
-				this->removeConnection(nei);
-			}
+			detach();
 		}
 		
 		/*Visiting status of this node. Used for traversal algorithms.*/
@@ -39,7 +48,15 @@ namespace ex{
 			if (std::find(neighbors.begin(), neighbors.end(), neighbor) == neighbors.end())
 			{
 				neighbors.push_back(neighbor);
-				neighbor.node->parents.push_back(this);
+				neighbor.node->parents.push_back(neighbor);
+				neighbor.node->parents.back().node = this;
+
+				/*Each side of the edge keeps the position of the other one, so the edge can
+				later be unlinked from both lists in constant time.*/
+				auto edge = std::prev(neighbors.end());
+				auto backEdge = std::prev(neighbor.node->parents.end());
+				edge->twin = backEdge;
+				backEdge->twin = edge;
 			}
 		}
 
@@ -47,15 +64,14 @@ namespace ex{
 		if there are three diferent neighbors containing this same 'node', but with 
 		different weights all three are removed anyway.*/
 		void removeConnection(GraphNode<D, W> *node){
-
-			auto pos = std::remove_if(neighbors.begin(), neighbors.end(), [&](Neighbor<D, W> &nei){
-				return nei.node == node;
-			});
-
-			for (auto it = pos; it != neighbors.end(); ++it){
-				it->node->parents.remove(this);
+			for (auto it = neighbors.begin(); it != neighbors.end();){
+				if (it->node == node){
+					node->parents.erase(it->twin);
+					it = neighbors.erase(it);
+				}
+				else
+					++it;
 			}
-			neighbors.erase(pos, neighbors.end());
 		}
 
 		/*Removes the exact neighbor of this node, that is, we use both the
@@ -64,18 +80,32 @@ namespace ex{
 			auto nodePos = std::find(neighbors.begin(), neighbors.end(), neighbor);
 			/*If node exists as a connection*/
 			if (nodePos != neighbors.end()){
-				neighbor.node->parents.remove(this);
+				nodePos->node->parents.erase(nodePos->twin);
 				neighbors.erase(nodePos);
 			}
 		}
 
+		/*Removes every edge arriving at or leaving this node. Since each edge knows where
+		its twin is stored, this takes O(degree), regardless of the degree of the other nodes.*/
+		void detach(){
+			for (Neighbor<D, W> &par : parents){
+				par.node->neighbors.erase(par.twin);
+			}
+			parents.clear();
+			for (Neighbor<D, W> &nei : neighbors){
+				nei.node->parents.erase(nei.twin);
+			}
+			neighbors.clear();
+		}
+
 		/*Nodes that this one is connected to. Since this actually represents
 		a connect (an edge), we use the class 'Neighbor' which encapsulates
 		a pointer to a 'GraphNode' as well as the weight of the edge.*/
 		std::list<Neighbor<D, W>> neighbors;
 
-		/*Nodes that connect to this one.*/
-		std::list<GraphNode<D, W>*> parents;
+		/*Nodes that connect to this one. These are the same edges stored in the parents'
+		'neighbors' lists, seen from the other side, so 'node' here points to the parent.*/
+		std::list<Neighbor<D, W>> parents;
 	};
 
 	template <class D, class W> std::ostream &operator<<(std::ostream &out, const GraphNode<D, W> *&node){
@@ -129,8 +159,23 @@ namespace ex{
 		Neighbor<D, W>(GraphNode<D, W> *node, W weight) : node(node), weight(weight){}
 		GraphNode<D, W> *node = nullptr;
 		W weight;
+
+		/*Position of the same edge in the list of the other endpoint, that is, in 'node->parents'
+		for an outgoing edge, or in 'node->neighbors' for an incoming one.*/
+		typename std::list<Neighbor<D, W>>::iterator twin;
 	};
 	template <class D, class W> bool operator==(const Neighbor<D, W> &lhs, const Neighbor<D, W> &rhs){
 		return lhs.node == rhs.node && lhs.weight == rhs.weight;
 	}
+
+	/*Edge of an unweighted graph. The constructor still accepts the (empty) weight, so
+	the code building edges doesn't need to know which kind of graph it is dealing with.*/
+	template <class D> struct Neighbor<D, unweighted>{
+		Neighbor<D, unweighted>(GraphNode<D, unweighted> *node, unweighted = unweighted()) : node(node){}
+		GraphNode<D, unweighted> *node = nullptr;
+		typename std::list<Neighbor<D, unweighted>>::iterator twin;
+	};
+	template <class D> bool operator==(const Neighbor<D, unweighted> &lhs, const Neighbor<D, unweighted> &rhs){
+		return lhs.node == rhs.node;
+	}
 };
\ No newline at end of file
@@ -0,0 +1,230 @@
+#ifndef GRAPH_ORDERING_H
+#define GRAPH_ORDERING_H
+
+#include <vector>
+#include <cmath>
+#include <utility>
+#include <numeric>
+#include <algorithm>
+
+namespace ex{
+
+	/*Ways of renumbering the nodes of a graph, so nodes that are traversed together are
+	also stored close together in memory.*/
+	enum class VertexOrdering{
+		/*Keeps the order in which nodes were pushed into the graph.*/
+		Insertion,
+		/*Nodes with more connections (in and out) come first.*/
+		Degree,
+		/*Reverse Cuthill-McKee: BFS from a low degree node of each component, visiting
+		neighbors by increasing degree, and then reversing the whole order.*/
+		Rcm,
+		/*Greedy ordering that places next the node sharing the most edges and parents with the
+		last few nodes placed, as in "Speedup Graph Processing by Graph Ordering" (Gorder).*/
+		Gorder
+	};
+
+	/*All functions below take a graph in compressed sparse row form, where the edges of node 'i'
+	are stored in 'targets' from offsets[i] to offsets[i + 1], and return the new order of the
+	nodes, that is, the old id of the node that should take each new id.*/
+
+	/*Builds the incoming edges of a graph, in the same form as the outgoing ones.*/
+	template <class Id> void transpose(const std::vector<std::size_t> &offsets, const std::vector<Id> &targets,
+		std::vector<std::size_t> &inOffsets, std::vector<Id> &inSources)
+	{
+		std::size_t n = offsets.size() - 1;
+		inOffsets.assign(n + 1, 0);
+		for (Id t : targets)
+			++inOffsets[t + 1];
+		std::partial_sum(inOffsets.begin(), inOffsets.end(), inOffsets.begin());
+
+		inSources.resize(targets.size());
+		std::vector<std::size_t> pos(inOffsets.begin(), inOffsets.end() - 1);
+		for (std::size_t v = 0; v < n; ++v){
+			for (std::size_t e = offsets[v]; e < offsets[v + 1]; ++e)
+				inSources[pos[targets[e]]++] = static_cast<Id>(v);
+		}
+	}
+
+	template <class Id> std::vector<Id> order_by_degree(const std::vector<std::size_t> &offsets, const std::vector<Id> &targets){
+		std::size_t n = offsets.size() - 1;
+		std::vector<std::size_t> degree(n);
+		for (std::size_t v = 0; v < n; ++v)
+			degree[v] = offsets[v + 1] - offsets[v];
+		for (Id t : targets)
+			++degree[t];
+
+		std::vector<Id> order(n);
+		std::iota(order.begin(), order.end(), Id(0));
+		std::stable_sort(order.begin(), order.end(), [&](Id a, Id b){
+			return degree[a] > degree[b];
+		});
+		return order;
+	}
+
+	template <class Id> std::vector<Id> order_rcm(const std::vector<std::size_t> &offsets, const std::vector<Id> &targets){
+		std::size_t n = offsets.size() - 1;
+		std::vector<std::size_t> inOffsets;
+		std::vector<Id> inSources;
+		transpose(offsets, targets, inOffsets, inSources);
+
+		/*Edge direction is ignored here, since both directions matter for locality.*/
+		std::vector<std::size_t> degree(n);
+		for (std::size_t v = 0; v < n; ++v)
+			degree[v] = offsets[v + 1] - offsets[v] + inOffsets[v + 1] - inOffsets[v];
+
+		std::vector<Id> byDegree(n);
+		std::iota(byDegree.begin(), byDegree.end(), Id(0));
+		std::stable_sort(byDegree.begin(), byDegree.end(), [&](Id a, Id b){
+			return degree[a] < degree[b];
+		});
+
+		std::vector<Id> order;
+		order.reserve(n);
+		std::vector<bool> queued(n, false);
+		std::vector<Id> candidates;
+		for (Id start : byDegree){
+			if (queued[start])
+				continue;
+			queued[start] = true;
+			order.push_back(start);
+			for (std::size_t head = order.size() - 1; head < order.size(); ++head){
+				Id v = order[head];
+				candidates.clear();
+				for (std::size_t e = offsets[v]; e < offsets[v + 1]; ++e){
+					if (!queued[targets[e]]){
+						queued[targets[e]] = true;
+						candidates.push_back(targets[e]);
+					}
+				}
+				for (std::size_t e = inOffsets[v]; e < inOffsets[v + 1]; ++e){
+					if (!queued[inSources[e]]){
+						queued[inSources[e]] = true;
+						candidates.push_back(inSources[e]);
+					}
+				}
+				std::stable_sort(candidates.begin(), candidates.end(), [&](Id a, Id b){
+					return degree[a] < degree[b];
+				});
+				order.insert(order.end(), candidates.begin(), candidates.end());
+			}
+		}
+		std::reverse(order.begin(), order.end());
+		return order;
+	}
+
+	template <class Id> std::vector<Id> order_gorder(const std::vector<std::size_t> &offsets, const std::vector<Id> &targets,
+		std::size_t window = 5)
+	{
+		std::size_t n = offsets.size() - 1;
+		std::vector<Id> order;
+		if (n == 0)
+			return order;
+		order.reserve(n);
+
+		std::vector<std::size_t> inOffsets;
+		std::vector<Id> inSources;
+		transpose(offsets, targets, inOffsets, inSources);
+
+		/*Parents with too many children would make every node placed touch a large part of
+		the graph. Their children are not counted as siblings, as suggested in the paper.*/
+		std::size_t hubDegree = std::max<std::size_t>(64, static_cast<std::size_t>(std::sqrt(double(n))));
+
+		/*'score' is how related each node is to the nodes inside the window. Unplaced nodes are
+		kept in doubly linked lists, one per score value, so a score can be raised or lowered in
+		constant time, and the best node is found by walking down from the highest score.*/
+		const Id none = static_cast<Id>(n);
+		std::vector<std::size_t> score(n, 0);
+		std::vector<Id> prev(n), next(n);
+		std::vector<Id> bucket(1, none);
+		std::size_t maxScore = 0;
+
+		auto unlink = [&](Id u){
+			if (prev[u] != none)
+				next[prev[u]] = next[u];
+			else
+				bucket[score[u]] = next[u];
+			if (next[u] != none)
+				prev[next[u]] = prev[u];
+		};
+		auto link = [&](Id u){
+			if (score[u] >= bucket.size())
+				bucket.resize(score[u] + 1, none);
+			prev[u] = none;
+			next[u] = bucket[score[u]];
+			if (next[u] != none)
+				prev[next[u]] = u;
+			bucket[score[u]] = u;
+		};
+		for (std::size_t v = n; v-- > 0;)
+			link(static_cast<Id>(v));
+
+		std::vector<bool> placed(n, false);
+		auto update = [&](Id v, bool entering){
+			auto bump = [&](Id u){
+				if (!placed[u]){
+					unlink(u);
+					if (entering)
+						maxScore = std::max(maxScore, ++score[u]);
+					else
+						--score[u];
+					link(u);
+				}
+			};
+			for (std::size_t e = offsets[v]; e < offsets[v + 1]; ++e)
+				bump(targets[e]);
+			for (std::size_t e = inOffsets[v]; e < inOffsets[v + 1]; ++e){
+				Id parent = inSources[e];
+				bump(parent);
+				if (offsets[parent + 1] - offsets[parent] <= hubDegree){
+					for (std::size_t s = offsets[parent]; s < offsets[parent + 1]; ++s)
+						bump(targets[s]);
+				}
+			}
+		};
+
+		/*The paper starts from the node with most incoming edges.*/
+		Id chosen = 0;
+		for (std::size_t v = 1; v < n; ++v){
+			if (inOffsets[v + 1] - inOffsets[v] > inOffsets[chosen + 1] - inOffsets[chosen])
+				chosen = static_cast<Id>(v);
+		}
+
+		while (true){
+			unlink(chosen);
+			placed[chosen] = true;
+			order.push_back(chosen);
+			update(chosen, true);
+			if (order.size() > window)
+				update(order[order.size() - window - 1], false);
+			if (order.size() == n)
+				break;
+
+			/*If nothing is related to the window, this ends at score 0, taking any remaining node.*/
+			while (bucket[maxScore] == none)
+				--maxScore;
+			chosen = bucket[maxScore];
+		}
+		return order;
+	}
+
+	template <class Id> std::vector<Id> compute_ordering(const std::vector<std::size_t> &offsets, const std::vector<Id> &targets,
+		VertexOrdering ordering)
+	{
+		switch (ordering){
+		case VertexOrdering::Degree:
+			return order_by_degree(offsets, targets);
+		case VertexOrdering::Rcm:
+			return order_rcm(offsets, targets);
+		case VertexOrdering::Gorder:
+			return order_gorder(offsets, targets);
+		default:
+			std::vector<Id> order(offsets.size() - 1);
+			std::iota(order.begin(), order.end(), Id(0));
+			return order;
+		}
+	}
+
+};
+
+#endif
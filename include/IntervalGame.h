@@ -0,0 +1,241 @@
+#ifndef INTERVAL_GAME_H
+#define INTERVAL_GAME_H
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include <type_traits>
+
+namespace ex{
+
+	/*Which end of the line a player takes the value from.*/
+	enum class Pick{ Left, Right };
+
+	template <class S> struct LineGameResult{
+		/*Totals collected by the player moving first and by the other one.*/
+		S firstScore = S();
+		S secondScore = S();
+		/*Picks made by both players, alternating, starting with the first player. Empty if
+		the moves were not requested.*/
+		std::vector<Pick> moves;
+	};
+
+	/*Barrier for threads that meet very often and only wait for short periods, so they spin
+	instead of sleeping.*/
+	class SpinBarrier{
+
+	public:
+
+		explicit SpinBarrier(unsigned count) : count(count), waiting(0), generation(0){}
+
+		void wait(){
+			unsigned gen = generation.load(std::memory_order_acquire);
+			if (waiting.fetch_add(1, std::memory_order_acq_rel) + 1 == count){
+				waiting.store(0, std::memory_order_relaxed);
+				generation.fetch_add(1, std::memory_order_release);
+			}
+			else{
+				for (unsigned spins = 0; generation.load(std::memory_order_acquire) == gen; ++spins){
+					if (spins > 1024)
+						std::this_thread::yield();
+				}
+			}
+		}
+
+	private:
+		const unsigned count;
+		std::atomic<unsigned> waiting;
+		std::atomic<unsigned> generation;
+	};
+
+	template <class S> struct IntervalGameResult{
+		/*Best difference between the player moving first and the other one, on the whole line.*/
+		S value = S();
+		/*Picks made by both players, alternating, starting with the first player. Empty if
+		the moves were not requested.*/
+		std::vector<Pick> moves;
+	};
+
+	/*Rule of the classic game, where the player to move adds the value taken to their total. A rule
+	gives, for an interval [s, e], the gain of picking each end, as the difference between the total 
+	of the player to move and of the other one. 'rest' is that same difference for the opponent, 
+	on the interval left after the pick. Other line-picking games only need another rule.*/
+	template <class S> struct TakeEndsRule{
+		explicit TakeEndsRule(const S *line) : line(line){}
+		S left(std::size_t s, std::size_t, S rest) const{ return line[s] - rest; }
+		S right(std::size_t, std::size_t e, S rest) const{ return line[e] - rest; }
+		const S *line;
+	};
+
+	/*Solves a two player game on a line of 'n' elements, where each move removes the element at
+	either end, and the gain of each move is given by 'rule' (see 'TakeEndsRule'). Both players
+	are assumed to play optimally.
+
+	For each interval [s, s + len) of the line, the table keeps the best value for the player to
+	move, which only depends on the intervals one element shorter. The table is filled one length
+	(a diagonal) at a time, keeping only the last one, so this takes O(n^2) time and O(n) memory.
+	Large diagonals are split between 'threads' threads (0 uses all available cores).
+
+	To return the moves, k = (2n)^(1/3) diagonals, evenly spaced, are kept as checkpoints, and the
+	part of the table between two checkpoints, along the optimal line of play, is recomputed from
+	them afterwards, one triangle of at most (n/k)^2/2 intervals at a time. The checkpoints hold
+	about n*k/2 values, so the extra memory is O(n^(4/3)) in all (about 4.5 million values for
+	n = 100000), and the extra work about 1/k of the table.*/
+	template <class S, class Rule> IntervalGameResult<S> solve_interval_game(std::size_t n, Rule rule,
+		bool withMoves = true, unsigned threads = 0)
+	{
+		IntervalGameResult<S> result;
+		if (n == 0)
+			return result;
+
+		/*Diagonals whose length is a multiple of 'stride' are kept as checkpoints. Their number
+		balances the memory of the checkpoints against the size of the triangles recomputed.*/
+		const std::size_t maxCheckpoints = std::max<std::size_t>(1,
+			static_cast<std::size_t>(std::cbrt(2.0 * static_cast<double>(n)) + 0.5));
+		const std::size_t stride = (n + maxCheckpoints - 1) / maxCheckpoints;
+		std::vector<std::vector<S>> checkpoints;
+		if (withMoves){
+			checkpoints.resize(n / stride);
+			for (std::size_t i = 0; i < checkpoints.size(); ++i)
+				checkpoints[i].resize(n - (i + 1) * stride + 1);
+		}
+
+		/*Best value for each interval of the current length (even or odd) and the previous one.
+		Intervals of length 0 are worth nothing, and one extra slot keeps that true for the
+		empty interval past the end of the line.*/
+		std::vector<S> diagonals[2] = { std::vector<S>(n + 1), std::vector<S>(n + 1) };
+
+		/*Computes the intervals of length 'len' starting in [first, last).*/
+		auto fillDiagonal = [&](std::size_t len, std::size_t first, std::size_t last){
+			const S *prev = diagonals[(len - 1) & 1].data();
+			S *cur = diagonals[len & 1].data();
+			const Rule r = rule;
+			for (std::size_t s = first; s < last; ++s){
+				cur[s] = std::max(r.left(s, s + len - 1, prev[s + 1]), r.right(s, s + len - 1, prev[s]));
+			}
+			if (withMoves && len % stride == 0)
+				std::copy(cur + first, cur + last, checkpoints[len / stride - 1].begin() + first);
+		};
+
+		if (threads == 0)
+			threads = std::max(1u, std::thread::hardware_concurrency());
+		/*Below this many intervals per thread, synchronizing costs more than it saves.*/
+		const std::size_t minPerThread = 2048;
+
+		std::size_t len = 1;
+		if (threads > 1 && n >= threads * minPerThread){
+			SpinBarrier barrier(threads);
+			const std::size_t lastParallel = n + 1 - threads * minPerThread;
+			auto worker = [&](unsigned t){
+				for (std::size_t l = 1; l <= lastParallel; ++l){
+					std::size_t count = n - l + 1;
+					fillDiagonal(l, count * t / threads, count * (t + 1) / threads);
+					barrier.wait();
+				}
+			};
+			std::vector<std::thread> team;
+			for (unsigned t = 1; t < threads; ++t)
+				team.push_back(std::thread(worker, t));
+			worker(0);
+			for (std::thread &th : team)
+				th.join();
+			len = lastParallel + 1;
+		}
+		for (; len <= n; ++len)
+			fillDiagonal(len, 0, n - len + 1);
+
+		result.value = diagonals[n & 1][0];
+		if (!withMoves)
+			return result;
+
+		/*Walks the line of play from the whole line down. For each stretch between two checkpoints,
+		the intervals inside the current one are recomputed from the checkpoint below it.*/
+		result.moves.reserve(n);
+		std::vector<std::vector<S>> rows;
+		std::size_t s = 0;
+		len = n;
+		while (len > 0){
+			std::size_t base = (len - 1) / stride * stride;
+			rows.resize(len - base);
+			rows[0].assign(len - base + 1, S());
+			if (base > 0){
+				const std::vector<S> &checkpoint = checkpoints[base / stride - 1];
+				std::copy(checkpoint.begin() + s, checkpoint.begin() + s + len - base + 1, rows[0].begin());
+			}
+			for (std::size_t l = base + 1; l < len; ++l){
+				const std::vector<S> &prev = rows[l - 1 - base];
+				std::vector<S> &cur = rows[l - base];
+				cur.resize(len - l + 1);
+				for (std::size_t i = 0; i < cur.size(); ++i){
+					cur[i] = std::max(rule.left(s + i, s + i + l - 1, prev[i + 1]), rule.right(s + i, s + i + l - 1, prev[i]));
+				}
+			}
+
+			/*Rows are indexed from the start of the interval the stretch began with.*/
+			const std::size_t origin = s;
+			for (; len > base; --len){
+				const std::vector<S> &shorter = rows[len - 1 - base];
+				S left = rule.left(s, s + len - 1, shorter[s + 1 - origin]);
+				S right = rule.right(s, s + len - 1, shorter[s - origin]);
+				if (left >= right){
+					result.moves.push_back(Pick::Left);
+					++s;
+				}
+				else
+					result.moves.push_back(Pick::Right);
+			}
+		}
+		return result;
+	}
+
+	/*Solves the game of 'solve_line_game' with values converted to 'S'.*/
+	template <class S, class T> IntervalGameResult<S> _solve_take_ends(const std::vector<T> &values, double,
+		bool withMoves, unsigned threads, std::false_type)
+	{
+		const std::vector<S> line(values.begin(), values.end());
+		return solve_interval_game<S>(line.size(), TakeEndsRule<S>(line.data()), withMoves, threads);
+	}
+	/*Integer values use 32-bit arithmetic whenever no total can overflow it, that is, when the sum
+	of their magnitudes fits.*/
+	template <class S, class T> IntervalGameResult<S> _solve_take_ends(const std::vector<T> &values, double magnitude,
+		bool withMoves, unsigned threads, std::true_type)
+	{
+		if (magnitude > 2147483647.0)
+			return _solve_take_ends<S>(values, magnitude, withMoves, threads, std::false_type());
+		IntervalGameResult<std::int32_t> game = _solve_take_ends<std::int32_t>(values, magnitude, withMoves, threads, std::false_type());
+		IntervalGameResult<S> result;
+		result.value = static_cast<S>(game.value);
+		result.moves.swap(game.moves);
+		return result;
+	}
+
+	/*Solves the game where two players take turns removing a value from either end of a line,
+	each one trying to end with the largest total. See 'solve_interval_game'. Integer values are
+	solved with 32-bit arithmetic whenever no total can overflow it, which lets the compiler fit
+	twice as many intervals in each vector instruction.*/
+	template <class T, class S = typename std::conditional<std::is_integral<T>::value, long long, T>::type>
+		LineGameResult<S> solve_line_game(const std::vector<T> &values, bool withMoves = true, unsigned threads = 0)
+	{
+		S sum = S();
+		double magnitude = 0.0;
+		for (const T &v : values){
+			sum += static_cast<S>(v);
+			magnitude += std::fabs(static_cast<double>(v));
+		}
+
+		IntervalGameResult<S> game = _solve_take_ends<S>(values, magnitude, withMoves, threads,
+			typename std::is_integral<T>::type());
+		LineGameResult<S> result;
+		S diff = game.value;
+		result.moves.swap(game.moves);
+		result.firstScore = (sum + diff) / 2;
+		result.secondScore = (sum - diff) / 2;
+		return result;
+	}
+
+};
+
+#endif